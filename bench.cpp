@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "red_black_tree.hpp"
+
+/*
+Minimal B+tree in the style of absl::btree_map, used as a cache-friendly baseline:
+sorted keys/values packed into wide nodes, leaves chained for iteration.
+Supports what the benchmark needs (try_emplace, find, lower_bound, iteration), no erase.
+*/
+template <typename Key, typename Value, typename Compare = std::less<Key>, std::size_t NodeSize = 32>
+class btree_map {
+    struct node {
+        bool leaf;
+        std::size_t count;
+    };
+
+    // one extra slot so a node can overflow before it is split
+    struct leaf_node : node {
+        Key keys[NodeSize + 1];
+        Value values[NodeSize + 1];
+        leaf_node *next;
+    };
+
+    struct inner_node : node {
+        Key keys[NodeSize + 1];
+        node *children[NodeSize + 2];
+    };
+
+    struct split_result {
+        Key key;
+        node *right;
+    };
+
+    node *root_ = nullptr;
+    leaf_node *first_ = nullptr;
+    std::size_t size_ = 0;
+    Compare comp_;
+
+public:
+    class iterator {
+        friend class btree_map;
+        leaf_node *leaf_ = nullptr;
+        std::size_t pos_ = 0;
+
+        iterator(leaf_node *leaf, std::size_t pos) : leaf_(leaf), pos_(pos) {
+            if (leaf_ != nullptr && pos_ == leaf_->count) {
+                leaf_ = leaf_->next;
+                pos_ = 0;
+            }
+        }
+
+    public:
+        iterator() = default;
+        const Key &key() const { return leaf_->keys[pos_]; }
+        Value &value() const { return leaf_->values[pos_]; }
+
+        iterator &operator++() {
+            if (++pos_ == leaf_->count) {
+                leaf_ = leaf_->next;
+                pos_ = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const iterator &other) const { return leaf_ == other.leaf_ && pos_ == other.pos_; }
+        bool operator!=(const iterator &other) const { return !(*this == other); }
+    };
+
+    btree_map() = default;
+    btree_map(const btree_map &) = delete;
+    btree_map &operator=(const btree_map &) = delete;
+    ~btree_map() { destroy(root_); }
+
+    std::size_t size() const { return size_; }
+    iterator begin() const { return iterator(first_, 0); }
+    iterator end() const { return iterator(); }
+
+    // returns only whether the key was inserted, so the benchmark doesn't pay for a second lookup
+    bool try_emplace(const Key &key, const Value &value) {
+        if (root_ == nullptr) {
+            leaf_node *leaf = new leaf_node;
+            leaf->leaf = true;
+            leaf->count = 0;
+            leaf->next = nullptr;
+            root_ = first_ = leaf;
+        }
+        split_result split{Key(), nullptr};
+        bool inserted = insert(root_, key, value, split);
+        if (split.right != nullptr) {
+            inner_node *root = new inner_node;
+            root->leaf = false;
+            root->count = 1;
+            root->keys[0] = split.key;
+            root->children[0] = root_;
+            root->children[1] = split.right;
+            root_ = root;
+        }
+        if (inserted) size_++;
+        return inserted;
+    }
+
+    iterator find(const Key &key) const {
+        iterator it = lower_bound(key);
+        if (it != end() && !comp_(key, it.key())) return it;
+        return end();
+    }
+
+    iterator lower_bound(const Key &key) const {
+        if (root_ == nullptr) return end();
+        node *n = root_;
+        while (!n->leaf) {
+            inner_node *inner = static_cast<inner_node *>(n);
+            std::size_t i = std::upper_bound(inner->keys, inner->keys + inner->count, key, comp_) - inner->keys;
+            n = inner->children[i];
+        }
+        leaf_node *leaf = static_cast<leaf_node *>(n);
+        std::size_t pos = std::lower_bound(leaf->keys, leaf->keys + leaf->count, key, comp_) - leaf->keys;
+        return iterator(leaf, pos);
+    }
+
+private:
+    bool insert(node *n, const Key &key, const Value &value, split_result &split) {
+        if (n->leaf) {
+            leaf_node *leaf = static_cast<leaf_node *>(n);
+            std::size_t pos = std::lower_bound(leaf->keys, leaf->keys + leaf->count, key, comp_) - leaf->keys;
+            if (pos < leaf->count && !comp_(key, leaf->keys[pos])) return false;
+            std::move_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            std::move_backward(leaf->values + pos, leaf->values + leaf->count, leaf->values + leaf->count + 1);
+            leaf->keys[pos] = key;
+            leaf->values[pos] = value;
+            if (++leaf->count > NodeSize) {
+                leaf_node *right = new leaf_node;
+                std::size_t half = leaf->count / 2;
+                right->leaf = true;
+                right->count = leaf->count - half;
+                std::move(leaf->keys + half, leaf->keys + leaf->count, right->keys);
+                std::move(leaf->values + half, leaf->values + leaf->count, right->values);
+                leaf->count = half;
+                right->next = leaf->next;
+                leaf->next = right;
+                split.key = right->keys[0];
+                split.right = right;
+            }
+            return true;
+        }
+
+        inner_node *inner = static_cast<inner_node *>(n);
+        std::size_t i = std::upper_bound(inner->keys, inner->keys + inner->count, key, comp_) - inner->keys;
+        split_result child_split{Key(), nullptr};
+        bool inserted = insert(inner->children[i], key, value, child_split);
+        if (child_split.right == nullptr) return inserted;
+
+        std::move_backward(inner->keys + i, inner->keys + inner->count, inner->keys + inner->count + 1);
+        std::move_backward(inner->children + i + 1, inner->children + inner->count + 1, inner->children + inner->count + 2);
+        inner->keys[i] = child_split.key;
+        inner->children[i + 1] = child_split.right;
+        if (++inner->count > NodeSize) {
+            inner_node *right = new inner_node;
+            std::size_t mid = inner->count / 2;
+            right->leaf = false;
+            right->count = inner->count - mid - 1;
+            std::move(inner->keys + mid + 1, inner->keys + inner->count, right->keys);
+            std::move(inner->children + mid + 1, inner->children + inner->count + 1, right->children);
+            split.key = inner->keys[mid];
+            split.right = right;
+            inner->count = mid;
+        }
+        return inserted;
+    }
+
+    void destroy(node *n) {
+        if (n == nullptr) return;
+        if (n->leaf) {
+            delete static_cast<leaf_node *>(n);
+            return;
+        }
+        inner_node *inner = static_cast<inner_node *>(n);
+        for (std::size_t i = 0; i <= inner->count; i++) {
+            destroy(inner->children[i]);
+        }
+        delete inner;
+    }
+};
+
+// uniform access to the element behind an iterator for each container
+template <typename It>
+static auto iter_key(const It &it) -> decltype(it->first) { return it->first; }
+template <typename It>
+static auto iter_key(const It &it) -> decltype(it.key()) { return it.key(); }
+template <typename It>
+static auto iter_value(const It &it) -> decltype(it->second) { return it->second; }
+template <typename It>
+static auto iter_value(const It &it) -> decltype(it.value()) { return it.value(); }
+
+static uint64_t splitmix64(uint64_t *state) {
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+typedef std::chrono::steady_clock bench_clock;
+
+static double ns_per_op(bench_clock::time_point start, std::size_t ops) {
+    std::chrono::duration<double, std::nano> elapsed = bench_clock::now() - start;
+    return elapsed.count() / (double)ops;
+}
+
+static uint64_t checksum = 0;
+
+template <typename Map>
+static void bench_map(const char *name, const std::vector<uint64_t> &keys, const std::vector<uint64_t> &lookups) {
+    Map map;
+
+    bench_clock::time_point start = bench_clock::now();
+    for (uint64_t key : keys) {
+        map.try_emplace(key, key);
+    }
+    double insert_ns = ns_per_op(start, keys.size());
+
+    start = bench_clock::now();
+    for (uint64_t key : keys) {
+        checksum += iter_value(map.find(key));
+    }
+    double find_ns = ns_per_op(start, keys.size());
+
+    start = bench_clock::now();
+    for (uint64_t key : lookups) {
+        auto it = map.lower_bound(key);
+        if (it != map.end()) checksum += iter_key(it);
+    }
+    double lower_bound_ns = ns_per_op(start, lookups.size());
+
+    start = bench_clock::now();
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        checksum += iter_value(it);
+    }
+    double iterate_ns = ns_per_op(start, map.size());
+
+    printf("%-14s %10.1f %10.1f %12.1f %10.2f", name, insert_ns, find_ns, lower_bound_ns, iterate_ns);
+    if constexpr (std::is_same_v<Map, btree_map<uint64_t, uint64_t>>) {
+        // the baseline has no erase
+        printf(" %10s\n", "-");
+    } else {
+        start = bench_clock::now();
+        for (uint64_t key : keys) {
+            map.erase(key);
+        }
+        printf(" %10.1f\n", ns_per_op(start, keys.size()));
+    }
+}
+
+int main(int argc, char **argv) {
+    std::size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 1000000;
+
+    uint64_t state = 42;
+    std::vector<uint64_t> keys(n);
+    for (uint64_t &key : keys) {
+        key = splitmix64(&state);
+    }
+    std::vector<uint64_t> lookups(n);
+    for (uint64_t &key : lookups) {
+        key = splitmix64(&state);
+    }
+
+    printf("%zu random uint64_t keys, ns/op\n\n", n);
+    printf("%-14s %10s %10s %12s %10s %10s\n", "container", "insert", "find", "lower_bound", "iterate", "erase");
+    bench_map<rb::tree<uint64_t, uint64_t>>("rb::tree", keys, lookups);
+    bench_map<std::map<uint64_t, uint64_t>>("std::map", keys, lookups);
+    bench_map<btree_map<uint64_t, uint64_t>>("btree_map", keys, lookups);
+
+    printf("\nchecksum %llu\n", (unsigned long long)checksum);
+    return 0;
+}
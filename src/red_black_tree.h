@@ -285,7 +285,7 @@ void *RED_BLACK_TREE_FUNC(delete)(RED_BLACK_TREE_NAME *tree, RED_BLACK_TREE_KEY_
                 }
             } else {
                 // key >= upper_node->key
-                if (upper_node->right->left == NULL) {
+                if (upper_node->right->right == NULL) {
                     if (upper_node->left->right == NULL) {
                         upper_node->left->color = RED;
                         upper_node->right->color = RED;
@@ -373,7 +373,7 @@ void *RED_BLACK_TREE_FUNC(delete)(RED_BLACK_TREE_NAME *tree, RED_BLACK_TREE_KEY_
                                 upper_node->left->left->color = BLACK;
                                 upper_node->left->right->color = BLACK;
                                 upper_node->left->color = RED;
-                                upper_node->left->left->color = RED;
+                                upper_node->left->left->left->color = RED;
                                 current_node = upper_node = upper_node->left->left;
                             } else {
                                 // upper_node->left->right->left is red and upper_node->left->right->right is black
@@ -0,0 +1,1077 @@
+#ifndef RED_BLACK_TREE_HPP
+#define RED_BLACK_TREE_HPP
+
+/*
+C++17 port of red_black_tree.h
+
+rb::tree<Key, Value, Compare> is an ordered map with the same leaf-oriented layout
+and top-down insert/delete as the C tree: internal nodes only route searches, values
+live in the leaves (a leaf's left pointer holds its value, right is NULL), and nodes
+come from a memory pool/free list instead of individual allocations.
+
+This is a separate copy of the algorithm, not a wrapper around the generated C code.
+red_black_tree.h and memory_pool.h don't compile as C++ (implicit conversions from
+void *), and the C header generates one set of functions per RED_BLACK_TREE_NAME with
+the comparison baked in as a macro, so it can't be instantiated per template argument.
+Here the algorithm is instantiated per Compare type, which lets the comparator inline
+the same way RED_BLACK_TREE_KEY_LESS_THAN does in C. The pool is rb::detail::memory_pool.
+
+Keep the two in sync: any fix to insert/delete in red_black_tree.h must be copied into
+emplace_unique/erase_unique here, and the reverse. The rotation and recoloring cases
+match the C code line for line to make that straightforward.
+
+Each leaf points to an entry holding a std::pair<const Key, Value>. Entries are never
+moved once constructed, so Value may be move-only and references/iterators stay valid
+until the element is erased (as with std::map). Entries are also linked in key order,
+which gives O(1) bidirectional iteration without parent pointers. Keys must be
+copy-constructible since internal nodes keep copies of them for routing.
+*/
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace rb {
+
+namespace detail {
+
+template <typename Key>
+struct node {
+    Key key;
+    node *left;
+    node *right;
+    uint8_t color;
+};
+
+struct list_node {
+    list_node *prev;
+    list_node *next;
+};
+
+template <typename T>
+struct entry : list_node {
+    T value;
+
+    template <typename... Args>
+    explicit entry(Args &&... args) : value(std::forward<Args>(args)...) {}
+};
+
+/*
+Fixed-size object pool with a free list, allocated in blocks of BlockSize objects.
+Hands out raw storage; construction and destruction are up to the caller.
+*/
+template <typename T, std::size_t BlockSize = 256>
+class memory_pool {
+    union slot {
+        slot *next;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    struct block {
+        block *next;
+        slot slots[BlockSize];
+    };
+
+    block *blocks_ = nullptr;
+    slot *free_list_ = nullptr;
+    std::size_t block_index_ = BlockSize;
+
+public:
+    memory_pool() noexcept = default;
+    memory_pool(const memory_pool &) = delete;
+    memory_pool &operator=(const memory_pool &) = delete;
+
+    memory_pool(memory_pool &&other) noexcept
+        : blocks_(std::exchange(other.blocks_, nullptr)),
+          free_list_(std::exchange(other.free_list_, nullptr)),
+          block_index_(std::exchange(other.block_index_, BlockSize)) {}
+
+    memory_pool &operator=(memory_pool &&other) noexcept {
+        if (this != &other) {
+            clear();
+            blocks_ = std::exchange(other.blocks_, nullptr);
+            free_list_ = std::exchange(other.free_list_, nullptr);
+            block_index_ = std::exchange(other.block_index_, BlockSize);
+        }
+        return *this;
+    }
+
+    ~memory_pool() { clear(); }
+
+    void *get() {
+        if (free_list_ != nullptr) {
+            slot *s = free_list_;
+            free_list_ = s->next;
+            return s->storage;
+        }
+        if (block_index_ == BlockSize) {
+            block *b = new block;
+            b->next = blocks_;
+            blocks_ = b;
+            block_index_ = 0;
+        }
+        return blocks_->slots[block_index_++].storage;
+    }
+
+    void release(void *ptr) noexcept {
+        slot *s = static_cast<slot *>(ptr);
+        s->next = free_list_;
+        free_list_ = s;
+    }
+
+    // Frees every block at once, objects must already be destroyed
+    void clear() noexcept {
+        while (blocks_ != nullptr) {
+            block *next = blocks_->next;
+            delete blocks_;
+            blocks_ = next;
+        }
+        free_list_ = nullptr;
+        block_index_ = BlockSize;
+    }
+};
+
+} // namespace detail
+
+template <typename Key, typename Value, typename Compare = std::less<Key>>
+class tree {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_compare = Compare;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using pointer = value_type *;
+    using const_pointer = const value_type *;
+
+private:
+    using node_type = detail::node<Key>;
+    using list_node = detail::list_node;
+    using entry_type = detail::entry<value_type>;
+
+    static constexpr uint8_t red = 0;
+    static constexpr uint8_t black = 1;
+
+    template <bool Const>
+    class iterator_impl {
+        friend class tree;
+        template <bool> friend class iterator_impl;
+
+        list_node *node_ = nullptr;
+
+        explicit iterator_impl(list_node *node) noexcept : node_(node) {}
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = typename tree::value_type;
+        using difference_type = typename tree::difference_type;
+        using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+        using reference = std::conditional_t<Const, const value_type &, value_type &>;
+
+        iterator_impl() noexcept = default;
+
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        iterator_impl(const iterator_impl<false> &other) noexcept : node_(other.node_) {}
+
+        reference operator*() const { return static_cast<entry_type *>(node_)->value; }
+        pointer operator->() const { return &static_cast<entry_type *>(node_)->value; }
+
+        iterator_impl &operator++() noexcept {
+            node_ = node_->next;
+            return *this;
+        }
+
+        iterator_impl operator++(int) noexcept {
+            iterator_impl tmp = *this;
+            node_ = node_->next;
+            return tmp;
+        }
+
+        iterator_impl &operator--() noexcept {
+            node_ = node_->prev;
+            return *this;
+        }
+
+        iterator_impl operator--(int) noexcept {
+            iterator_impl tmp = *this;
+            node_ = node_->prev;
+            return tmp;
+        }
+
+        friend bool operator==(const iterator_impl &a, const iterator_impl &b) noexcept { return a.node_ == b.node_; }
+        friend bool operator!=(const iterator_impl &a, const iterator_impl &b) noexcept { return a.node_ != b.node_; }
+    };
+
+public:
+    using iterator = iterator_impl<false>;
+    using const_iterator = iterator_impl<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    tree() : tree(Compare()) {}
+
+    explicit tree(const Compare &comp) : comp_(comp) {
+        header_.prev = header_.next = &header_;
+    }
+
+    template <typename InputIt>
+    tree(InputIt first, InputIt last, const Compare &comp = Compare()) : tree(comp) {
+        insert(first, last);
+    }
+
+    tree(std::initializer_list<value_type> init, const Compare &comp = Compare()) : tree(comp) {
+        insert(init.begin(), init.end());
+    }
+
+    tree(const tree &other) : tree(other.comp_) {
+        for (const value_type &value : other) {
+            try_emplace(value.first, value.second);
+        }
+    }
+
+    tree(tree &&other) noexcept
+        : root_(std::exchange(other.root_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          comp_(std::move(other.comp_)),
+          nodes_(std::move(other.nodes_)),
+          entries_(std::move(other.entries_)) {
+        take_list(other);
+    }
+
+    tree &operator=(const tree &other) {
+        if (this != &other) {
+            tree tmp(other);
+            *this = std::move(tmp);
+        }
+        return *this;
+    }
+
+    tree &operator=(tree &&other) noexcept {
+        if (this != &other) {
+            clear();
+            root_ = std::exchange(other.root_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            comp_ = std::move(other.comp_);
+            nodes_ = std::move(other.nodes_);
+            entries_ = std::move(other.entries_);
+            take_list(other);
+        }
+        return *this;
+    }
+
+    ~tree() { clear(); }
+
+    iterator begin() noexcept { return iterator(header_.next); }
+    const_iterator begin() const noexcept { return const_iterator(header_.next); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    iterator end() noexcept { return iterator(&header_); }
+    const_iterator end() const noexcept { return const_iterator(const_cast<list_node *>(&header_)); }
+    const_iterator cend() const noexcept { return end(); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return rbegin(); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return rend(); }
+
+    bool empty() const noexcept { return size_ == 0; }
+    size_type size() const noexcept { return size_; }
+    key_compare key_comp() const { return comp_; }
+
+    /*
+    Debug helper for tests, not part of the map interface: checks keys are ordered, no red
+    node has a red child, every path has the same black height, and the leaves and iteration
+    order both hold exactly size() elements. O(n).
+    */
+    bool check_invariants_for_testing() const {
+        size_type num_entries = 0;
+        for (const list_node *node = header_.next; node != &header_; node = node->next) {
+            if (node->next != &header_ && !key_less(static_cast<const entry_type *>(node)->value.first,
+                                                    static_cast<const entry_type *>(node->next)->value.first)) {
+                return false;
+            }
+            num_entries++;
+        }
+        if (num_entries != size_) return false;
+        if (root_ == nullptr) return size_ == 0;
+        size_type num_leaves = 0;
+        if (root_->color != black || check_subtree(root_, nullptr, nullptr, num_leaves) < 0) return false;
+        return num_leaves == size_;
+    }
+
+    void clear() noexcept {
+        if (root_ != nullptr) {
+            if constexpr (!std::is_trivially_destructible_v<value_type>) {
+                for (list_node *node = header_.next; node != &header_;) {
+                    list_node *next = node->next;
+                    static_cast<entry_type *>(node)->~entry_type();
+                    node = next;
+                }
+            }
+            if constexpr (!std::is_trivially_destructible_v<Key>) {
+                destroy_keys(root_);
+            }
+        }
+        // every object is destroyed, so whole blocks can go back at once,
+        // including blocks left on the free lists after erasing every element
+        nodes_.clear();
+        entries_.clear();
+        root_ = nullptr;
+        size_ = 0;
+        header_.prev = header_.next = &header_;
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const key_type &key, Args &&... args) {
+        return emplace_unique(key, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(key_type &&key, Args &&... args) {
+        return emplace_unique(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args &&... args) {
+        value_type value(std::forward<Args>(args)...);
+        return emplace_unique(value.first, std::move(value.second));
+    }
+
+    std::pair<iterator, bool> insert(const value_type &value) {
+        return emplace_unique(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> insert(value_type &&value) {
+        return emplace_unique(value.first, std::move(value.second));
+    }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> init) {
+        insert(init.begin(), init.end());
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const key_type &key, M &&obj) {
+        std::pair<iterator, bool> result = emplace_unique(key, std::forward<M>(obj));
+        if (!result.second) result.first->second = std::forward<M>(obj);
+        return result;
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(key_type &&key, M &&obj) {
+        std::pair<iterator, bool> result = emplace_unique(std::move(key), std::forward<M>(obj));
+        if (!result.second) result.first->second = std::forward<M>(obj);
+        return result;
+    }
+
+    mapped_type &operator[](const key_type &key) {
+        return emplace_unique(key).first->second;
+    }
+
+    mapped_type &operator[](key_type &&key) {
+        return emplace_unique(std::move(key)).first->second;
+    }
+
+    mapped_type &at(const key_type &key) {
+        iterator it = find(key);
+        if (it == end()) throw std::out_of_range("rb::tree::at");
+        return it->second;
+    }
+
+    const mapped_type &at(const key_type &key) const {
+        const_iterator it = find(key);
+        if (it == end()) throw std::out_of_range("rb::tree::at");
+        return it->second;
+    }
+
+    size_type erase(const key_type &key) {
+        return erase_unique(key);
+    }
+
+    iterator erase(const_iterator pos) {
+        iterator next(pos.node_->next);
+        erase_unique(pos->first);
+        return next;
+    }
+
+    iterator erase(iterator pos) {
+        return erase(const_iterator(pos));
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        while (first != last) {
+            first = erase(first);
+        }
+        return iterator(last.node_);
+    }
+
+    void swap(tree &other) noexcept {
+        tree tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    iterator find(const key_type &key) { return iterator(find_entry(key)); }
+    const_iterator find(const key_type &key) const { return const_iterator(find_entry(key)); }
+
+    size_type count(const key_type &key) const { return find_entry(key) != &header_ ? 1 : 0; }
+    bool contains(const key_type &key) const { return find_entry(key) != &header_; }
+
+    iterator lower_bound(const key_type &key) { return iterator(lower_bound_entry(key)); }
+    const_iterator lower_bound(const key_type &key) const { return const_iterator(lower_bound_entry(key)); }
+
+    iterator upper_bound(const key_type &key) { return iterator(upper_bound_entry(key)); }
+    const_iterator upper_bound(const key_type &key) const { return const_iterator(upper_bound_entry(key)); }
+
+    std::pair<iterator, iterator> equal_range(const key_type &key) {
+        iterator first = lower_bound(key);
+        iterator last = (first != end() && !key_less(key, first->first)) ? std::next(first) : first;
+        return {first, last};
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const {
+        const_iterator first = lower_bound(key);
+        const_iterator last = (first != end() && !key_less(key, first->first)) ? std::next(first) : first;
+        return {first, last};
+    }
+
+private:
+    node_type *root_ = nullptr;
+    list_node header_;
+    size_type size_ = 0;
+    Compare comp_;
+    detail::memory_pool<node_type> nodes_;
+    detail::memory_pool<entry_type> entries_;
+
+    bool key_less(const Key &a, const Key &b) const {
+        return comp_(a, b);
+    }
+
+    bool key_equals(const Key &a, const Key &b) const {
+        return !comp_(a, b) && !comp_(b, a);
+    }
+
+    static bool node_is_leaf(const node_type *node) noexcept {
+        return node->right == nullptr;
+    }
+
+    // leaves keep their entry in the left pointer, as the C tree does with its value
+    static entry_type *leaf_entry(const node_type *node) noexcept {
+        return reinterpret_cast<entry_type *>(node->left);
+    }
+
+    static node_type *entry_node(entry_type *entry) noexcept {
+        return reinterpret_cast<node_type *>(entry);
+    }
+
+    // rotations keep the top node in place and swap keys instead of copying them
+    static void rotate_left(node_type *node) noexcept {
+        node_type *right = node->right;
+        node->right = right->right;
+        right->right = right->left;
+        right->left = node->left;
+        node->left = right;
+        using std::swap;
+        swap(node->key, right->key);
+    }
+
+    static void rotate_right(node_type *node) noexcept {
+        node_type *left = node->left;
+        node->left = left->left;
+        left->left = left->right;
+        left->right = node->right;
+        node->right = left;
+        using std::swap;
+        swap(node->key, left->key);
+    }
+
+    node_type *new_node(const Key &key, node_type *left, uint8_t color) {
+        void *ptr = nodes_.get();
+        node_type *node;
+        try {
+            node = ::new (ptr) node_type{key, left, nullptr, color};
+        } catch (...) {
+            nodes_.release(ptr);
+            throw;
+        }
+        return node;
+    }
+
+    void delete_node(node_type *node) noexcept {
+        node->~node_type();
+        nodes_.release(node);
+    }
+
+    template <typename K, typename... Args>
+    entry_type *new_entry(K &&key, Args &&... args) {
+        void *ptr = entries_.get();
+        entry_type *entry;
+        try {
+            entry = ::new (ptr) entry_type(std::piecewise_construct,
+                                           std::forward_as_tuple(std::forward<K>(key)),
+                                           std::forward_as_tuple(std::forward<Args>(args)...));
+        } catch (...) {
+            entries_.release(ptr);
+            throw;
+        }
+        return entry;
+    }
+
+    void delete_entry(entry_type *entry) noexcept {
+        entry->~entry_type();
+        entries_.release(entry);
+    }
+
+    static void unlink(list_node *node) noexcept {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+    }
+
+    static void link_before(list_node *pos, list_node *node) noexcept {
+        node->prev = pos->prev;
+        node->next = pos;
+        pos->prev->next = node;
+        pos->prev = node;
+    }
+
+    void take_list(tree &other) noexcept {
+        if (other.header_.next == &other.header_) {
+            header_.prev = header_.next = &header_;
+            return;
+        }
+        header_.prev = other.header_.prev;
+        header_.next = other.header_.next;
+        header_.prev->next = &header_;
+        header_.next->prev = &header_;
+        other.header_.prev = other.header_.next = &other.header_;
+    }
+
+    void destroy_keys(node_type *node) noexcept {
+        if (!node_is_leaf(node)) {
+            destroy_keys(node->left);
+            destroy_keys(node->right);
+        }
+        node->key.~Key();
+    }
+
+    // black height of the subtree with keys in [lower, upper), -1 on violation
+    int check_subtree(const node_type *node, const Key *lower, const Key *upper, size_type &num_leaves) const {
+        if (lower != nullptr && key_less(node->key, *lower)) return -1;
+        if (node_is_leaf(node)) {
+            if (upper != nullptr && !key_less(node->key, *upper)) return -1;
+            if (!key_equals(node->key, leaf_entry(node)->value.first)) return -1;
+            num_leaves++;
+            return node->color == black ? 1 : 0;
+        }
+        if (upper != nullptr && key_less(*upper, node->key)) return -1;
+        if (node->color == red && (node->left->color == red || node->right->color == red)) return -1;
+        int left_height = check_subtree(node->left, lower, &node->key, num_leaves);
+        int right_height = check_subtree(node->right, &node->key, upper, num_leaves);
+        if (left_height < 0 || left_height != right_height) return -1;
+        return left_height + (node->color == black ? 1 : 0);
+    }
+
+    /*
+    Leaf where a search for key ends. Routing keys in internal nodes can be stale after an
+    erase, so this isn't necessarily the largest key <= key. What does hold is that no stored
+    key lies strictly between the leaf and key: the leaf is either the largest key <= key or
+    the smallest key > key, which is what lower_bound_entry/upper_bound_entry rely on.
+    */
+    node_type *find_leaf(const key_type &key) const {
+        node_type *node = root_;
+        while (!node_is_leaf(node)) {
+            node = key_less(key, node->key) ? node->left : node->right;
+        }
+        return node;
+    }
+
+    list_node *find_entry(const key_type &key) const {
+        list_node *end = const_cast<list_node *>(&header_);
+        if (root_ == nullptr) return end;
+        node_type *leaf = find_leaf(key);
+        return key_equals(key, leaf->key) ? leaf_entry(leaf) : end;
+    }
+
+    list_node *lower_bound_entry(const key_type &key) const {
+        if (root_ == nullptr) return const_cast<list_node *>(&header_);
+        node_type *leaf = find_leaf(key);
+        entry_type *entry = leaf_entry(leaf);
+        return key_less(leaf->key, key) ? entry->next : entry;
+    }
+
+    list_node *upper_bound_entry(const key_type &key) const {
+        if (root_ == nullptr) return const_cast<list_node *>(&header_);
+        node_type *leaf = find_leaf(key);
+        entry_type *entry = leaf_entry(leaf);
+        return key_less(key, leaf->key) ? entry : entry->next;
+    }
+
+    template <typename K, typename... Args>
+    std::pair<iterator, bool> emplace_unique(K &&key, Args &&... args) {
+        /*
+        Top-down insertion, same as red_black_tree.h. The entry is only constructed
+        once the key is known to be missing, so args are left untouched otherwise.
+        */
+        if (root_ == nullptr) {
+            // empty tree
+            entry_type *entry = new_entry(std::forward<K>(key), std::forward<Args>(args)...);
+            try {
+                // root is always black
+                root_ = new_node(entry->value.first, entry_node(entry), black);
+            } catch (...) {
+                delete_entry(entry);
+                throw;
+            }
+            link_before(&header_, entry);
+            size_ = 1;
+            return {iterator(entry), true};
+        }
+        node_type *node = root_;
+
+        node_type *current_node, *next_node, *upper_node;
+        current_node = node;
+        upper_node = nullptr;
+        while (current_node->right != nullptr) {
+            if (key_less(key, current_node->key)) {
+                next_node = current_node->left;
+            } else {
+                next_node = current_node->right;
+            }
+            if (current_node->color == black) {
+                if (current_node->left->color == black || current_node->right->color == black) {
+                    upper_node = current_node;
+                    current_node = next_node;
+                } else {
+                    // both children of current_node are red, need rebalance
+                    if (upper_node == nullptr) {
+                        // current_node is root
+                        current_node->left->color = black;
+                        current_node->right->color = black;
+                        upper_node = current_node;
+                    } else if (key_less(current_node->key, upper_node->key)) {
+                        // current_node is the left child of upper_node
+                        if (current_node == upper_node->left) {
+                            // case 1, recoloring only
+                            current_node->left->color = black;
+                            current_node->right->color = black;
+                            current_node->color = red;
+                        } else if (current_node == upper_node->left->left) {
+                            // case 2, zig zig case, one rotation
+                            rotate_right(upper_node);
+                            upper_node->left->color = red;
+                            upper_node->right->color = red;
+                            upper_node->left->left->color = black;
+                            upper_node->left->right->color = black;
+                        } else {
+                            // case 3, zig zag case, current_node == upper_node->left->right
+                            rotate_left(upper_node->left);
+                            rotate_right(upper_node);
+                            upper_node->left->color = red;
+                            upper_node->right->color = red;
+                            upper_node->right->left->color = black;
+                            upper_node->left->right->color = black;
+                        }
+                    } else {
+                        // current_node->key >= upper_node->key
+                        if (current_node == upper_node->right) {
+                            // case 1, recoloring only
+                            current_node->left->color = black;
+                            current_node->right->color = black;
+                            current_node->color = red;
+                        } else if (current_node == upper_node->right->right) {
+                            // case 2, zig zig case, one rotation
+                            rotate_left(upper_node);
+                            upper_node->left->color = red;
+                            upper_node->right->color = red;
+                            upper_node->right->left->color = black;
+                            upper_node->right->right->color = black;
+                        } else {
+                            // case 3, zig zag case, two rotations
+                            rotate_right(upper_node->right);
+                            rotate_left(upper_node);
+                            upper_node->left->color = red;
+                            upper_node->right->color = red;
+                            upper_node->right->left->color = black;
+                            upper_node->left->right->color = black;
+                        }
+                    }
+                    current_node = next_node;
+                    upper_node = current_node;
+                }
+            } else {
+                // current_node is red, move down
+                current_node = next_node;
+            }
+        } // end while, always arrives on black leaf
+
+        if (key_equals(key, current_node->key)) {
+            // key already exists
+            return {iterator(leaf_entry(current_node)), false};
+        }
+        // current_node is the leaf that will become the parent of the new leaf
+        entry_type *old_entry = leaf_entry(current_node);
+        entry_type *entry = new_entry(std::forward<K>(key), std::forward<Args>(args)...);
+        // key may have been moved into the entry, compare against the entry's copy from here on
+        const Key &new_key = entry->value.first;
+        bool new_leaf_right = key_less(current_node->key, new_key);
+        node_type *old_leaf = nullptr;
+        node_type *new_leaf = nullptr;
+        try {
+            old_leaf = new_node(current_node->key, current_node->left, red);
+            new_leaf = new_node(new_key, entry_node(entry), red);
+            if (new_leaf_right) current_node->key = new_key;
+        } catch (...) {
+            if (new_leaf != nullptr) delete_node(new_leaf);
+            if (old_leaf != nullptr) delete_node(old_leaf);
+            delete_entry(entry);
+            throw;
+        }
+        if (new_leaf_right) {
+            current_node->left = old_leaf;
+            current_node->right = new_leaf;
+            link_before(old_entry->next, entry);
+        } else {
+            current_node->left = new_leaf;
+            current_node->right = old_leaf;
+            link_before(old_entry, entry);
+        }
+        size_++;
+        return {iterator(entry), true};
+    }
+
+    size_type erase_unique(const key_type &key) {
+        node_type *node = root_;
+        if (node == nullptr) return 0;
+        if (node_is_leaf(node)) {
+            // root is a leaf
+            if (!key_equals(key, node->key)) return 0;
+            unlink(leaf_entry(node));
+            delete_entry(leaf_entry(node));
+            delete_node(node);
+            root_ = nullptr;
+            size_ = 0;
+            return 1;
+        }
+
+        node_type *current_node, *upper_node;
+        upper_node = node;
+        if (upper_node->left->color == black && upper_node->right->color == black) {
+            if (key_less(key, upper_node->key)) {
+                if (upper_node->left->right == nullptr) {
+                    if (upper_node->right->right == nullptr) {
+                        upper_node->left->color = red;
+                        upper_node->right->color = red;
+                    } else {
+                        upper_node->right->left->color = black;
+                        upper_node->right->right->color = black;
+                        upper_node->right->color = red;
+                    }
+                } else {
+                    if (upper_node->left->left->color == red || upper_node->left->right->color == red) {
+                        upper_node = upper_node->left;
+                    } else if (upper_node->right->right->color == red) {
+                        rotate_left(upper_node);
+                        upper_node->right->color = black;
+                        upper_node->left->color = black;
+                        upper_node->left->left->color = red;
+                        upper_node = upper_node->left;
+                    } else if (upper_node->right->left->color == red) {
+                        rotate_right(upper_node->right);
+                        rotate_left(upper_node);
+                        upper_node->right->color = black;
+                        upper_node->left->color = black;
+                        upper_node->left->left->color = red;
+                        upper_node = upper_node->left;
+                    } else {
+                        upper_node->left->color = red;
+                        upper_node->right->color = red;
+                    }
+                }
+            } else {
+                // key >= upper_node->key
+                if (upper_node->right->right == nullptr) {
+                    if (upper_node->left->right == nullptr) {
+                        upper_node->left->color = red;
+                        upper_node->right->color = red;
+                    } else {
+                        upper_node->left->left->color = black;
+                        upper_node->left->right->color = black;
+                        upper_node->left->color = red;
+                    }
+                } else {
+                    if (upper_node->right->right->color == red || upper_node->right->left->color == red) {
+                        upper_node = upper_node->right;
+                    } else if (upper_node->left->left->color == red) {
+                        rotate_right(upper_node);
+                        upper_node->right->color = black;
+                        upper_node->left->color = black;
+                        upper_node->right->right->color = red;
+                        upper_node = upper_node->right;
+                    } else if (upper_node->left->right->color == red) {
+                        rotate_left(upper_node->left);
+                        rotate_right(upper_node);
+                        upper_node->right->color = black;
+                        upper_node->left->color = black;
+                        upper_node->right->right->color = red;
+                        upper_node = upper_node->right;
+                    } else {
+                        // left and right have only black nodes as neighbors below
+                        upper_node->left->color = red;
+                        upper_node->right->color = red;
+                    }
+                }
+            }
+        } // upper node has at least one red neighbor blow
+
+        current_node = upper_node;
+        while (!node_is_leaf(current_node)) {
+            if (key_less(key, current_node->key)) {
+                current_node = current_node->left;
+            } else {
+                current_node = current_node->right;
+            }
+            if (current_node->color == red || node_is_leaf(current_node)) {
+                continue;
+            } else {
+                // current_node is black and not a leaf
+                if (current_node->left->color == red || current_node->right->color == red) {
+                    // at least one child of the current node is black
+                    upper_node = current_node;
+                } else {
+                    // both children of the current node are black
+                    if (key_less(current_node->key, upper_node->key)) {
+                        if (current_node == upper_node->left) {
+                            if (upper_node->right->left->left->color == black && upper_node->right->left->right->color == black) {
+                                rotate_left(upper_node);
+                                upper_node->left->color = black;
+                                upper_node->left->left->color = red;
+                                upper_node->left->right->color = red;
+                                current_node = upper_node = upper_node->left;
+                            } else if (upper_node->right->left->left->color == red) {
+                                rotate_right(upper_node->right->left);
+                                rotate_right(upper_node->right);
+                                rotate_left(upper_node);
+                                upper_node->left->color = black;
+                                upper_node->right->left->color = black;
+                                upper_node->right->color = red;
+                                upper_node->left->left->color = red;
+                                current_node = upper_node = upper_node->left;
+                            } else {
+                                // upper_node->right->left->left is black and upper_node->right->left->right is red
+                                rotate_right(upper_node->right);
+                                rotate_left(upper_node);
+                                upper_node->left->color = black;
+                                upper_node->right->left->color = black;
+                                upper_node->right->color = red;
+                                upper_node->left->left->color = red;
+                                current_node = upper_node = upper_node->left;
+                            }
+                        } else if (current_node == upper_node->left->left) {
+                            if (upper_node->left->right->left->color == black && upper_node->left->right->right->color == black) {
+                                upper_node->left->left->color = red;
+                                upper_node->left->right->color = red;
+                                upper_node->left->color = black;
+                                current_node = upper_node = upper_node->left;
+                            } else if (upper_node->left->right->right->color == red) {
+                                rotate_left(upper_node->left);
+                                upper_node->left->left->color = black;
+                                upper_node->left->right->color = black;
+                                upper_node->left->color = red;
+                                upper_node->left->left->left->color = red;
+                                current_node = upper_node = upper_node->left->left;
+                            } else {
+                                // upper_node->left->right->left is red and upper_node->left->right->right is black
+                                rotate_right(upper_node->left->right);
+                                rotate_left(upper_node->left);
+                                upper_node->left->left->color = black;
+                                upper_node->left->right->color = black;
+                                upper_node->left->color = red;
+                                upper_node->left->left->left->color = red;
+                                current_node = upper_node = upper_node->left->left;
+                            }
+                        } else {
+                            // current_node == upper_node->left->right
+                            if (upper_node->left->left->left->color == black && upper_node->left->left->right->color == black) {
+                                upper_node->left->left->color = red;
+                                upper_node->left->right->color = red;
+                                upper_node->left->color = black;
+                                current_node = upper_node = upper_node->left;
+                            } else if (upper_node->left->left->left->color == red) {
+                                rotate_right(upper_node->left);
+                                upper_node->left->left->color = black;
+                                upper_node->left->right->color = black;
+                                upper_node->left->color = red;
+                                upper_node->left->right->right->color = red;
+                                current_node = upper_node = upper_node->left->right;
+                            } else {
+                                // upper_node->left->left->left is black and upper_node->left->left->right is red
+                                rotate_left(upper_node->left->left);
+                                rotate_right(upper_node->left);
+                                upper_node->left->left->color = black;
+                                upper_node->left->right->color = black;
+                                upper_node->left->color = red;
+                                upper_node->left->right->right->color = red;
+                                current_node = upper_node = upper_node->left->right;
+                            }
+
+                        }
+                    } else {
+                        // current_node->key >= upper_node->key
+                        if (current_node == upper_node->right) {
+                            if (upper_node->left->right->right->color == black && upper_node->left->right->left->color == black) {
+                                rotate_right(upper_node);
+                                upper_node->right->color = black;
+                                upper_node->right->right->color = red;
+                                upper_node->right->left->color = red;
+                                current_node = upper_node = upper_node->right;
+                            } else if (upper_node->left->right->right->color == red) {
+                                rotate_left(upper_node->left->right);
+                                rotate_left(upper_node->left);
+                                rotate_right(upper_node);
+                                upper_node->right->color = black;
+                                upper_node->left->right->color = black;
+                                upper_node->left->color = red;
+                                upper_node->right->right->color = red;
+                                current_node = upper_node = upper_node->right;
+                            } else {
+                                // upper_node->left->right->right is black and upper_node->left->right->left is red
+                                rotate_left(upper_node->left);
+                                rotate_right(upper_node);
+                                upper_node->right->color = black;
+                                upper_node->left->right->color = black;
+                                upper_node->left->color = red;
+                                upper_node->right->right->color = red;
+                                current_node = upper_node = upper_node->right;
+                            }
+                        } else if (current_node == upper_node->right->right) {
+                            if (upper_node->right->left->right->color == black && upper_node->right->left->left->color == black) {
+                                upper_node->right->left->color = red;
+                                upper_node->right->right->color = red;
+                                upper_node->right->color = black;
+                                current_node = upper_node = upper_node->right;
+                            } else if (upper_node->right->left->left->color == red) {
+                                rotate_right(upper_node->right);
+                                upper_node->right->left->color = black;
+                                upper_node->right->right->color = black;
+                                upper_node->right->color = red;
+                                upper_node->right->right->right->color = red;
+                                current_node = upper_node = upper_node->right->right;
+                            } else {
+                                //  upper_node->right->left->left is black and upper_node->right->left->right is red
+                                rotate_left(upper_node->right->left);
+                                rotate_right(upper_node->right);
+                                upper_node->right->left->color = black;
+                                upper_node->right->right->color = black;
+                                upper_node->right->color = red;
+                                upper_node->right->right->right->color = red;
+                                current_node = upper_node = upper_node->right->right;
+                            }
+                        } else {
+                            // current_node == upper_node->right->left
+                            if (upper_node->right->right->right->color == black && upper_node->right->right->left->color == black) {
+                                upper_node->right->left->color = red;
+                                upper_node->right->right->color = red;
+                                upper_node->right->color = black;
+                                current_node = upper_node = upper_node->right;
+                            } else if (upper_node->right->right->right->color == red) {
+                                rotate_left(upper_node->right);
+                                upper_node->right->left->color = black;
+                                upper_node->right->right->color = black;
+                                upper_node->right->color = red;
+                                upper_node->right->left->left->color = red;
+                                current_node = upper_node = upper_node->right->left;
+                            } else {
+                                // upper_node->right->right->right is black and upper_node->right->right->left is red
+                                rotate_right(upper_node->right->right);
+                                rotate_left(upper_node->right);
+                                upper_node->right->left->color = black;
+                                upper_node->right->right->color = black;
+                                upper_node->right->color = red;
+                                upper_node->right->left->left->color = red;
+                                current_node = upper_node = upper_node->right->left;
+                            }
+                        }
+                    }
+                }
+            }
+        } // end while, always arrives on black leaf
+
+        if (!key_equals(key, current_node->key)) {
+            // key doesn't exist
+            return 0;
+        }
+        /*
+        upper_node is the black node preceding the leaf to be deleted (current_node)
+        One of upper_node's children is red. If the red node is the parent of current_node, the leaf,
+        then we delete both the red node and the leaf. Otherwise, we perform a rotation on upper_node
+        to bring the red node above the leaf, then delete the leaf and the red node.
+        */
+        node_type *tmp_node;
+        if (key_less(current_node->key, upper_node->key)) {
+            if (current_node == upper_node->left) {
+                // upper_node->right is red
+                tmp_node = upper_node->right;
+                upper_node->key = std::move(tmp_node->key);
+                upper_node->left = tmp_node->left;
+                upper_node->right = tmp_node->right;
+            } else if (current_node == upper_node->left->left) {
+                // upper_node->left is red
+                tmp_node = upper_node->left;
+                upper_node->left = tmp_node->right;
+            } else {
+                // current_node == upper_node->left->right
+                tmp_node = upper_node->left;
+                upper_node->left = tmp_node->left;
+            }
+        } else {
+            if (current_node == upper_node->right) {
+                // upper_node->left is red
+                tmp_node = upper_node->left;
+                upper_node->key = std::move(tmp_node->key);
+                upper_node->left = tmp_node->left;
+                upper_node->right = tmp_node->right;
+            } else if (current_node == upper_node->right->right) {
+                // upper_node->right is red
+                tmp_node = upper_node->right;
+                upper_node->right = tmp_node->left;
+            } else {
+                // current_node == upper_node->right->left
+                tmp_node = upper_node->right;
+                upper_node->right = tmp_node->right;
+            }
+        }
+        // key may refer to the erased element, so the entry goes last
+        delete_node(tmp_node);
+        entry_type *entry = leaf_entry(current_node);
+        unlink(entry);
+        delete_entry(entry);
+        delete_node(current_node);
+        size_--;
+        return 1;
+    }
+};
+
+template <typename Key, typename Value, typename Compare>
+void swap(tree<Key, Value, Compare> &a, tree<Key, Value, Compare> &b) noexcept {
+    a.swap(b);
+}
+
+} // namespace rb
+
+#endif // RED_BLACK_TREE_HPP
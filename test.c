@@ -106,6 +106,89 @@ TEST test_red_black_tree(void) {
 }
 
 
+#define TEST_RANDOM_KEYS 512
+#define TEST_RANDOM_OPS 50000
+
+// color values used by red_black_tree.h, which undefines RED and BLACK at the end
+#define TEST_RED 0
+#define TEST_BLACK 1
+
+/*
+Walks the subtree, checking that leaf keys are in [lower, upper), internal keys separate
+their subtrees, there are no red-red edges and every path has the same black height.
+Returns the black height or -1 on violation, adds the number of leaves to num_leaves.
+*/
+static int red_black_tree_uint32_check(red_black_tree_uint32_node_t *node, uint64_t lower, uint64_t upper, size_t *num_leaves) {
+    if (node->right == NULL) {
+        if (node->key < lower || node->key >= upper) return -1;
+        (*num_leaves)++;
+        return node->color == TEST_BLACK ? 1 : 0;
+    }
+    if (node->key < lower || node->key > upper) return -1;
+    if (node->color == TEST_RED && (node->left->color == TEST_RED || node->right->color == TEST_RED)) return -1;
+    int left_height = red_black_tree_uint32_check(node->left, lower, node->key, num_leaves);
+    int right_height = red_black_tree_uint32_check(node->right, node->key, upper, num_leaves);
+    if (left_height < 0 || left_height != right_height) return -1;
+    return left_height + (node->color == TEST_BLACK ? 1 : 0);
+}
+
+static bool red_black_tree_uint32_valid(red_black_tree_uint32 *tree, size_t num_keys) {
+    if (tree->root->left == NULL) return num_keys == 0;
+    size_t num_leaves = 0;
+    if (red_black_tree_uint32_check(tree->root, 0, UINT64_MAX, &num_leaves) < 0) return false;
+    return num_leaves == num_keys;
+}
+
+TEST test_red_black_tree_random(void) {
+    red_black_tree_uint32 *tree = red_black_tree_uint32_new();
+    static char values[TEST_RANDOM_KEYS];
+    bool present[TEST_RANDOM_KEYS] = {false};
+    size_t num_keys = 0;
+
+    uint32_t state = 1;
+    for (size_t i = 0; i < TEST_RANDOM_OPS; i++) {
+        state = state * 1103515245 + 12345;
+        uint32_t key = (state >> 16) % TEST_RANDOM_KEYS;
+        if (state & (1 << 30)) {
+            bool inserted = red_black_tree_uint32_insert(tree, key, &values[key]);
+            ASSERT_EQ(inserted, !present[key]);
+            if (inserted) {
+                present[key] = true;
+                num_keys++;
+            }
+        } else {
+            char *value = red_black_tree_uint32_delete(tree, key);
+            ASSERT_EQ(value, present[key] ? &values[key] : NULL);
+            if (value != NULL) {
+                present[key] = false;
+                num_keys--;
+            }
+        }
+        ASSERT(red_black_tree_uint32_valid(tree, num_keys));
+    }
+
+    for (uint32_t key = 0; key < TEST_RANDOM_KEYS; key++) {
+        char *value = red_black_tree_uint32_get(tree->root, key);
+        ASSERT_EQ(value, present[key] ? &values[key] : NULL);
+    }
+
+    // drain in an order that differs from insertion
+    for (uint32_t i = 0; i < TEST_RANDOM_KEYS; i++) {
+        uint32_t key = (i * 337) % TEST_RANDOM_KEYS;
+        if (!present[key]) continue;
+        ASSERT_EQ(red_black_tree_uint32_delete(tree, key), &values[key]);
+        present[key] = false;
+        num_keys--;
+        ASSERT(red_black_tree_uint32_valid(tree, num_keys));
+    }
+
+    ASSERT_EQ(num_keys, 0);
+    ASSERT(tree->root->left == NULL);
+
+    red_black_tree_uint32_destroy(tree);
+    PASS();
+}
+
 
 /* Add definitions that need to be in the test runner's main file. */
 GREATEST_MAIN_DEFS();
@@ -114,6 +197,7 @@ int main(int argc, char **argv) {
     GREATEST_MAIN_BEGIN();      /* command-line options, initialization. */
 
     RUN_TEST(test_red_black_tree);
+    RUN_TEST(test_red_black_tree_random);
 
     GREATEST_MAIN_END();        /* display results */
 }
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "greatest/greatest.h"
+
+#include "red_black_tree.hpp"
+
+using tree_uint32 = rb::tree<uint32_t, std::string>;
+
+static_assert(std::is_same_v<std::iterator_traits<tree_uint32::iterator>::iterator_category, std::bidirectional_iterator_tag>);
+static_assert(std::is_same_v<std::iterator_traits<tree_uint32::const_iterator>::reference, const tree_uint32::value_type &>);
+static_assert(std::is_convertible_v<tree_uint32::iterator, tree_uint32::const_iterator>);
+static_assert(!std::is_convertible_v<tree_uint32::const_iterator, tree_uint32::iterator>);
+
+TEST test_red_black_tree_cpp(void) {
+    tree_uint32 tree;
+
+    const uint32_t keys[] = {7, 18, 3, 26, 22, 11, 8, 10, 15};
+    const char *values[] = {"a", "b", "c", "d", "e", "f", "g", "h", "i"};
+    for (size_t i = 0; i < 9; i++) {
+        ASSERT(tree.try_emplace(keys[i], values[i]).second);
+    }
+    ASSERT_EQ(tree.size(), 9);
+
+    for (size_t i = 0; i < 9; i++) {
+        tree_uint32::iterator it = tree.find(keys[i]);
+        ASSERT(it != tree.end());
+        ASSERT_STR_EQ(it->second.c_str(), values[i]);
+    }
+
+    ASSERT_FALSE(tree.try_emplace(7, "z").second);
+    ASSERT_STR_EQ(tree.at(7).c_str(), "a");
+
+    ASSERT_EQ(tree.erase(10), 1);
+    ASSERT_EQ(tree.erase(26), 1);
+    ASSERT_EQ(tree.erase(18), 1);
+    ASSERT_EQ(tree.erase(7), 1);
+    ASSERT_EQ(tree.erase(3), 1);
+    ASSERT_EQ(tree.erase(3), 0);
+    ASSERT(tree.find(3) == tree.end());
+
+    tree[3] = "c";
+    ASSERT_STR_EQ(tree.find(3)->second.c_str(), "c");
+    ASSERT_EQ(tree.erase(3), 1);
+    ASSERT_FALSE(tree.contains(3));
+
+    ASSERT_EQ(tree.erase(22), 1);
+    ASSERT_EQ(tree.erase(11), 1);
+    ASSERT_EQ(tree.erase(8), 1);
+    ASSERT_EQ(tree.erase(15), 1);
+
+    ASSERT(tree.empty());
+    ASSERT(tree.begin() == tree.end());
+    PASS();
+}
+
+TEST test_red_black_tree_cpp_iterators(void) {
+    tree_uint32 tree;
+    std::vector<uint32_t> keys;
+    for (uint32_t i = 0; i < 1000; i++) {
+        keys.push_back((i * 7919) % 1000);
+    }
+    for (uint32_t key : keys) {
+        tree.try_emplace(key, std::to_string(key));
+    }
+    ASSERT_EQ(tree.size(), 1000);
+
+    uint32_t expected = 0;
+    for (const tree_uint32::value_type &value : tree) {
+        ASSERT_EQ(value.first, expected);
+        ASSERT_STR_EQ(value.second.c_str(), std::to_string(expected).c_str());
+        expected++;
+    }
+
+    expected = 999;
+    for (tree_uint32::const_reverse_iterator it = tree.crbegin(); it != tree.crend(); ++it) {
+        ASSERT_EQ(it->first, expected);
+        expected--;
+    }
+
+    ASSERT_EQ(std::prev(tree.end())->first, 999);
+    ASSERT_EQ(std::distance(tree.begin(), tree.end()), 1000);
+
+    // erasing by iterator returns the next element and leaves the rest valid
+    tree_uint32::iterator last = std::prev(tree.end());
+    tree_uint32::iterator it = tree.begin();
+    while (it != tree.end()) {
+        it = tree.erase(it);
+        if (it != tree.end()) ++it;
+    }
+    ASSERT_EQ(tree.size(), 500);
+    ASSERT_EQ(last->first, 999);
+    expected = 1;
+    for (const tree_uint32::value_type &value : tree) {
+        ASSERT_EQ(value.first, expected);
+        expected += 2;
+    }
+    PASS();
+}
+
+TEST test_red_black_tree_cpp_bounds(void) {
+    tree_uint32 tree;
+    for (uint32_t key = 10; key <= 50; key += 10) {
+        tree.try_emplace(key, std::to_string(key));
+    }
+
+    ASSERT_EQ(tree.lower_bound(0)->first, 10);
+    ASSERT_EQ(tree.lower_bound(10)->first, 10);
+    ASSERT_EQ(tree.lower_bound(11)->first, 20);
+    ASSERT_EQ(tree.lower_bound(50)->first, 50);
+    ASSERT(tree.lower_bound(51) == tree.end());
+
+    ASSERT_EQ(tree.upper_bound(0)->first, 10);
+    ASSERT_EQ(tree.upper_bound(10)->first, 20);
+    ASSERT(tree.upper_bound(50) == tree.end());
+
+    std::pair<tree_uint32::iterator, tree_uint32::iterator> range = tree.equal_range(30);
+    ASSERT_EQ(std::distance(range.first, range.second), 1);
+    range = tree.equal_range(35);
+    ASSERT(range.first == range.second);
+    ASSERT_EQ(range.first->first, 40);
+
+    // erasing leaves stale routing keys behind, bounds must not depend on them
+    ASSERT_EQ(tree.erase(20), 1);
+    ASSERT_EQ(tree.erase(30), 1);
+    ASSERT_EQ(tree.lower_bound(25)->first, 40);
+    ASSERT_EQ(tree.upper_bound(25)->first, 40);
+    ASSERT_EQ(tree.lower_bound(15)->first, 40);
+    ASSERT_EQ(tree.upper_bound(10)->first, 40);
+    ASSERT(tree.find(25) == tree.end());
+
+    tree_uint32 empty;
+    ASSERT(empty.lower_bound(10) == empty.end());
+    ASSERT(empty.upper_bound(10) == empty.end());
+    ASSERT(empty.find(10) == empty.end());
+    PASS();
+}
+
+TEST test_red_black_tree_cpp_move_only(void) {
+    rb::tree<uint32_t, std::unique_ptr<uint32_t>> tree;
+    for (uint32_t key = 0; key < 100; key++) {
+        ASSERT(tree.try_emplace(key, std::make_unique<uint32_t>(key * 2)).second);
+    }
+
+    // try_emplace leaves its arguments alone when the key exists
+    std::unique_ptr<uint32_t> value = std::make_unique<uint32_t>(1);
+    ASSERT_FALSE(tree.try_emplace(5, std::move(value)).second);
+    ASSERT(value != nullptr);
+
+    uint32_t *addr = tree.find(50)->second.get();
+    for (uint32_t key = 0; key < 100; key += 2) {
+        tree.erase(key + 1);
+    }
+    ASSERT_EQ(tree.find(50)->second.get(), addr);
+
+    rb::tree<uint32_t, std::unique_ptr<uint32_t>> moved = std::move(tree);
+    ASSERT(tree.empty());
+    ASSERT_EQ(moved.size(), 50);
+    ASSERT_EQ(*moved.at(50), 100);
+    ASSERT_EQ(std::prev(moved.end())->first, 98);
+    PASS();
+}
+
+TEST test_red_black_tree_cpp_compare(void) {
+    rb::tree<std::string, uint32_t, std::greater<std::string>> tree;
+    const char *keys[] = {"b", "d", "a", "e", "c"};
+    for (uint32_t i = 0; i < 5; i++) {
+        tree.try_emplace(keys[i], i);
+    }
+
+    std::string joined;
+    for (const auto &value : tree) {
+        joined += value.first;
+    }
+    ASSERT_STR_EQ(joined.c_str(), "edcba");
+    ASSERT_STR_EQ(tree.lower_bound("bb")->first.c_str(), "b");
+
+    rb::tree<std::string, uint32_t, std::greater<std::string>> copy = tree;
+    ASSERT(std::equal(tree.begin(), tree.end(), copy.begin(), copy.end()));
+    PASS();
+}
+
+TEST test_red_black_tree_cpp_random(void) {
+    tree_uint32 tree;
+    std::map<uint32_t, std::string> expected;
+    uint32_t state = 1;
+    for (uint32_t i = 0; i < 100000; i++) {
+        state = state * 1103515245 + 12345;
+        uint32_t key = (state >> 16) % 2000;
+        if (state & (1 << 30)) {
+            ASSERT_EQ(tree.try_emplace(key, std::to_string(i)).second, expected.try_emplace(key, std::to_string(i)).second);
+        } else {
+            ASSERT_EQ(tree.erase(key), expected.erase(key));
+        }
+        if (i % 64 == 0) {
+            ASSERT(tree.check_invariants_for_testing());
+        }
+    }
+    ASSERT(tree.check_invariants_for_testing());
+    ASSERT_EQ(tree.size(), expected.size());
+    ASSERT(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+
+    // drain in an order that differs from insertion
+    for (uint32_t i = 0; i < 2000; i++) {
+        uint32_t key = (i * 337) % 2000;
+        ASSERT_EQ(tree.erase(key), expected.erase(key));
+        ASSERT(tree.check_invariants_for_testing());
+    }
+    ASSERT(tree.empty());
+
+    // clear() on an emptied tree releases the pooled blocks, the tree stays usable
+    tree.clear();
+    ASSERT(tree.try_emplace(7, "a").second);
+    ASSERT(tree.check_invariants_for_testing());
+    ASSERT_STR_EQ(tree.at(7).c_str(), "a");
+    PASS();
+}
+
+/* Add definitions that need to be in the test runner's main file. */
+GREATEST_MAIN_DEFS();
+
+int main(int argc, char **argv) {
+    GREATEST_MAIN_BEGIN();      /* command-line options, initialization. */
+
+    RUN_TEST(test_red_black_tree_cpp);
+    RUN_TEST(test_red_black_tree_cpp_iterators);
+    RUN_TEST(test_red_black_tree_cpp_bounds);
+    RUN_TEST(test_red_black_tree_cpp_move_only);
+    RUN_TEST(test_red_black_tree_cpp_compare);
+    RUN_TEST(test_red_black_tree_cpp_random);
+
+    GREATEST_MAIN_END();        /* display results */
+}